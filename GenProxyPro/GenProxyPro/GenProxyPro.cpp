@@ -16,6 +16,11 @@
 //   --exclude <regex>               : excluir exports que casem com regex (nome)
 //   --keep-ordinals                 : preservar layout de ordinais; relata lacunas (RVA=0)
 //   --respect-existing-forwarders   : manter forwarders nativos (DLL.Func) em vez de apontar para *_orig
+//   --profile <counts.csv>          : contagens por export (nome|#ordinal,contagem); marca exports quentes (json/stats)
+//   --hot-top <N>                   : no máximo N exports quentes (default: sem limite)
+//   --hot-cover <pct>               : quentes = menor conjunto que cobre pct% das chamadas (default: 90)
+//   --hot-stubs                     : modo stub/hook (requer --profile): quentes viram stubs em .text$hot que saltam
+//                                     por gpx_hot_tbl (.data); frios continuam forwarders. Gera hotstubs_x64.asm (x64)
 //   --verbose                       : logs verbosos
 
 
@@ -31,6 +36,7 @@
 #include <regex>
 #include <fstream>
 #include <iostream>
+#include "ProfileLayout.h"
 
 // -------------------- Utilidades básicas --------------------
 
@@ -131,6 +137,8 @@ struct ExportItem {
     bool isForwardString{};
     bool probableData{};
     std::string forwardTarget; // "DLL.Func" se forward nativo
+    uint64_t calls{};      // contagem do --profile (0 => frio)
+    bool hot{};            // quente após LimitHot; vira stub só com --hot-stubs
 };
 
 static bool ExtractExports(PEView& pe, std::vector<ExportItem>& out, DWORD& ordinalBase) {
@@ -185,6 +193,8 @@ struct Options {
     std::wstring origSuffix = L"_orig";
     bool emitDef{}, emitJson{}, emitHost{}, keepOrdinals{}, respectFwd{}, verbose{ true };
     bool hasInclude{}, hasExclude{}; std::wregex reInclude, reExclude;
+    bool hasProfile{}; std::wstring profilePath;
+    bool hotStubs{}; size_t hotTop{}; unsigned hotCover = 90;
 };
 
 static void ParseArgs(int argc, wchar_t** argv, Options& o) {
@@ -219,11 +229,18 @@ static void ParseArgs(int argc, wchar_t** argv, Options& o) {
         else if (k == L"--emit-host") o.emitHost = true;
         else if (k == L"--keep-ordinals") o.keepOrdinals = true;
         else if (k == L"--respect-existing-forwarders") o.respectFwd = true;
+        else if (k == L"--profile" && i + 1 < argc) { o.hasProfile = true; o.profilePath = argv[++i]; }
+        else if (k == L"--hot-top" && i + 1 < argc) o.hotTop = (size_t)wcstoul(argv[++i], nullptr, 10);
+        else if (k == L"--hot-cover" && i + 1 < argc) o.hotCover = (unsigned)wcstoul(argv[++i], nullptr, 10);
+        else if (k == L"--hot-stubs") o.hotStubs = true;
         else if (k == L"--include" && i + 1 < argc) { o.hasInclude = true; o.reInclude = std::wregex(argv[++i], std::regex::icase); }
         else if (k == L"--exclude" && i + 1 < argc) { o.hasExclude = true; o.reExclude = std::wregex(argv[++i], std::regex::icase); }
         else if (k == L"--verbose") o.verbose = true;
         else { fwprintf(stderr, L"[!] Opção desconhecida: %ls\n", k.c_str()); ExitProcess(1); }
     }
+
+    if (o.hotStubs && !o.hasProfile) { fwprintf(stderr, L"[!] --hot-stubs requer --profile\n"); ExitProcess(1); }
+    if (o.hotCover < 1 || o.hotCover > 100) { fwprintf(stderr, L"[!] --hot-cover deve estar entre 1 e 100\n"); ExitProcess(1); }
 }
 
 static bool NamePassesFilters(const Options& o, const std::string& name) {
@@ -234,6 +251,22 @@ static bool NamePassesFilters(const Options& o, const std::string& name) {
     return true;
 }
 
+// -------------------- Perfil de chamadas (--profile) --------------------
+
+// Export pode virar stub quente? Só código real que será de fato exportado pela proxy.
+static bool HotEligible(const Options& o, const ExportItem& e) {
+    if (e.rva == 0 || e.probableData) return false;                       // lacuna / dados: jmp não faz sentido
+    if (!e.name.empty() && !NamePassesFilters(o, e.name)) return false;  // não será emitido
+    if (o.respectFwd && e.isForwardString && !e.forwardTarget.empty()) return false; // forwarder nativo mantido
+    return true;
+}
+
+static std::string HotStubName(size_t i) { return "gpx_hot_" + std::to_string(i); }
+
+// Sem --hot-stubs todo export continua forwarder: o loader liga o chamador direto na DLL real,
+// sem código da proxy no caminho. Stub só faz sentido quando se quer um ponto de hook por export.
+static bool EmitsStub(const Options& o, const ExportItem& e) { return o.hotStubs && e.hot; }
+
 // -------------------- Emissão de artefatos --------------------
 
 static void WriteJsonReport(const std::wstring& path, const std::vector<ExportItem>& exps) {
@@ -247,6 +280,8 @@ static void WriteJsonReport(const std::wstring& path, const std::vector<ExportIt
             << ", \"rva\": " << e.rva
             << ", \"is_forward\": " << (e.isForwardString ? 1 : 0)
             << ", \"probable_data\": " << (e.probableData ? 1 : 0)
+            << ", \"calls\": " << e.calls
+            << ", \"hot\": " << (e.hot ? 1 : 0)
             << ", \"forward_target\": \"" << e.forwardTarget << "\" }";
         js << (i + 1 < exps.size() ? ",\n" : "\n");
     }
@@ -289,11 +324,16 @@ static void EmitDef(const std::wstring& pathDef,
     auto renamed = base + origSuffix;
 
     d << "LIBRARY " << WideToUtf8(base) << "\nEXPORTS\n";
+    size_t hotIdx = 0;
     for (const auto& e : exps) {
         if (e.rva == 0) { if (keepOrdinals) {/* lacuna mantida implicitamente */ } continue; }
         if (!e.name.empty() && !NamePassesFilters(opt, e.name)) continue;
 
-        if (!e.name.empty()) {
+        if (EmitsStub(opt, e)) {
+            if (!e.name.empty()) d << e.name << "=" << HotStubName(hotIdx++) << "\n";
+            else d << HotStubName(hotIdx++) << " @" << e.ordinal << " NONAME\n";
+        }
+        else if (!e.name.empty()) {
             if (respectFwd && e.isForwardString && !e.forwardTarget.empty())
                 d << e.name << "=" << e.forwardTarget << "\n";
             else
@@ -305,6 +345,82 @@ static void EmitDef(const std::wstring& pathDef,
     }
 }
 
+// Stubs quentes (--hot-stubs): cada stub é "jmp [gpx_hot_tbl + i]". A tabela fica em .data e é
+// preenchida no DLL_PROCESS_ATTACH; nenhuma página de código é reescrita (compatível com ACG).
+// Os stubs ficam contíguos em .text$hot na ordem de OrderByProfile (contagem desc).
+static void EmitHotStubs(std::ofstream& f, const std::vector<ExportItem>& exps, size_t hotTotal) {
+    f << R"(
+// ---- Stubs quentes (--hot-stubs), ordem = contagem de chamadas desc ----
+// Ponto de hook: troque gpx_hot_tbl[i] para interceptar o export i.
+// Custo: 1 salto indireto por chamada a mais que um forwarder.
+#define GPX_HOT_COUNT )" << hotTotal << R"(
+extern "C" { void* gpx_hot_tbl[GPX_HOT_COUNT] = {}; }
+
+#if defined(_M_X64)
+// x64: stubs em hotstubs_x64.asm (adicione ao projeto com a customização MASM habilitada)
+#elif defined(_M_IX86)
+#pragma code_seg(push, ".text$hot")
+)";
+    size_t i = 0;
+    for (const auto& e : exps) {
+        if (!e.hot) continue;
+        f << "extern \"C\" __declspec(naked) void " << HotStubName(i) << "() { __asm jmp dword ptr [gpx_hot_tbl + "
+            << i * 4 << "] } // " << (e.name.empty() ? "#" + std::to_string(e.ordinal) : e.name) << " calls=" << e.calls << "\n";
+        i++;
+    }
+    f << R"(#pragma code_seg(pop)
+#else
+#error "--hot-stubs suporta apenas x86/x64"
+#endif
+
+static const LPCSTR kHotProc[GPX_HOT_COUNT] = {
+)";
+    for (const auto& e : exps) {
+        if (!e.hot) continue;
+        if (e.name.empty()) f << "    MAKEINTRESOURCEA(" << e.ordinal << "),\n";
+        else f << "    \"" << e.name << "\",\n";
+    }
+    f << R"(};
+
+// Alvo não resolvido => DLL_PROCESS_ATTACH falha (LoadLibrary retorna erro) em vez de um stub sem destino.
+static BOOL ResolveHotStubs(HMODULE real) {
+    if (!real) { OutputDebugStringW(L"[proxy] DLL real não carregada; stubs quentes sem alvo\n"); return FALSE; }
+    for (int i = 0; i < GPX_HOT_COUNT; i++) {
+        FARPROC p = GetProcAddress(real, kHotProc[i]);
+        if (!p) {
+            OutputDebugStringW(L"[proxy] export quente não encontrado na DLL real: ");
+            OutputDebugStringA(IS_INTRESOURCE(kHotProc[i]) ? "#ordinal" : kHotProc[i]);
+            OutputDebugStringW(L"\n");
+            return FALSE;
+        }
+        gpx_hot_tbl[i] = (void*)p;
+    }
+    return TRUE;
+}
+)";
+}
+
+// x64 não tem __asm/naked no MSVC: os stubs vão num .asm (ml64) com seção .text$hot.
+static void EmitHotStubsAsm(const std::wstring& path, const std::vector<ExportItem>& exps) {
+    std::ofstream a(WideToUtf8(path), std::ios::binary);
+    if (!a) { fwprintf(stderr, L"[!] Não foi possível criar: %ls\n", path.c_str()); ExitProcess(5); }
+    a << "; hotstubs_x64.asm - gerado por GenProxyPro (--hot-stubs); montar com ml64 junto com dllmain.cpp\n"
+        "; stubs contiguos em .text$hot, ordem = contagem de chamadas desc; saltam por gpx_hot_tbl (.data)\n\n"
+        "EXTERN gpx_hot_tbl:QWORD\n\n"
+        "GPXHOT SEGMENT ALIGN(16) EXECUTE READ ALIAS(\".text$hot\") 'CODE'\n";
+    size_t i = 0;
+    for (const auto& e : exps) {
+        if (!e.hot) continue;
+        auto n = HotStubName(i);
+        a << "\nALIGN 16\n" << n << " PROC ; " << (e.name.empty() ? "#" + std::to_string(e.ordinal) : e.name)
+            << " calls=" << e.calls << "\n"
+            << "    jmp QWORD PTR [gpx_hot_tbl + " << i * 8 << "]\n"
+            << n << " ENDP\n";
+        i++;
+    }
+    a << "\nGPXHOT ENDS\nEND\n";
+}
+
 static void EmitDllMainCpp(const std::wstring& outPath,
     const std::wstring& inDllName,
     const std::wstring& origSuffix,
@@ -343,7 +459,13 @@ static void SafeSetDefaultDllDirectories() {
     Fn p = (Fn)GetProcAddress(k32, "SetDefaultDllDirectories");
     if (p) p(LOAD_LIBRARY_SEARCH_DEFAULT_DIRS);
 }
+)";
+
+    size_t hotTotal = 0;
+    if (opt.hotStubs) for (const auto& e : exps) if (e.hot) hotTotal++;
+    if (hotTotal) EmitHotStubs(f, exps, hotTotal);
 
+    f << R"(
 static BOOL CALLBACK InitReal(PINIT_ONCE, PVOID, PVOID*) {
     // Pega o diretório da proxy usando __ImageBase
     wchar_t modPath[MAX_PATH];
@@ -377,14 +499,14 @@ BOOL WINAPI DllMain(HINSTANCE hinst, DWORD reason, LPVOID) {
     if (reason == DLL_PROCESS_ATTACH) {
         DisableThreadLibraryCalls(hinst);
         InitOnceExecuteOnce(&gOnce, InitReal, NULL, NULL);
-    }
+)" << (hotTotal ? "        if (!ResolveHotStubs(gReal)) return FALSE;\n" : "") << R"(    }
     return TRUE;
 }
 
 // ---- Forwarders gerados automaticamente ----
 )";
 
-    size_t byName = 0, byOrd = 0, dataCnt = 0, fwdCnt = 0, keptCnt = 0, gaps = 0;
+    size_t byName = 0, byOrd = 0, dataCnt = 0, fwdCnt = 0, keptCnt = 0, gaps = 0, hotCnt = 0;
 
     for (const auto& e : exps) {
         if (e.rva == 0) { if (opt.keepOrdinals) gaps++; continue; }
@@ -393,7 +515,13 @@ BOOL WINAPI DllMain(HINSTANCE hinst, DWORD reason, LPVOID) {
 
         if (!e.name.empty() && !NamePassesFilters(opt, e.name)) continue;
 
-        if (!e.name.empty()) {
+        if (EmitsStub(opt, e)) {
+            // stub quente: exporta o stub em vez de encaminhar ao loader
+            auto stub = HotStubName(hotCnt++);
+            if (!e.name.empty()) f << "#pragma comment(linker, \"/export:" << e.name << "=" << stub << "\")\n";
+            else f << "#pragma comment(linker, \"/export:" << stub << ",@" << e.ordinal << ",NONAME\")\n";
+        }
+        else if (!e.name.empty()) {
             if (opt.respectFwd && e.isForwardString && !e.forwardTarget.empty()) {
                 // mantém forwarder nativo exatamente como está
                 f << "#pragma comment(linker, \"/export:" << e.name << "=" << e.forwardTarget << "\")\n";
@@ -416,7 +544,10 @@ BOOL WINAPI DllMain(HINSTANCE hinst, DWORD reason, LPVOID) {
         << " byOrdinal=" << byOrd
         << " keptForwarders=" << keptCnt
         << " gaps(RVA=0)=" << gaps
-        << " probableData=" << dataCnt << "\n";
+        << " probableData=" << dataCnt;
+    if (opt.hasProfile) f << " hot=" << std::count_if(exps.begin(), exps.end(), [](const ExportItem& e) { return e.hot; })
+        << " hotStubs=" << hotCnt;
+    f << "\n";
 }
 
 // -------------------- main --------------------
@@ -444,6 +575,31 @@ int wmain(int argc, wchar_t** argv) {
         return 4;
     }
 
+    if (opt.hasProfile) {
+        std::ifstream in(WideToUtf8(opt.profilePath), std::ios::binary);
+        if (!in) {
+            fwprintf(stderr, L"[!] Não foi possível ler o perfil: %ls\n", opt.profilePath.c_str());
+            return 6;
+        }
+        CallProfile prof;
+        ParseProfile(in, prof);
+        ProfileMatch m = ApplyProfile(prof, exps, [&](const ExportItem& e) { return HotEligible(opt, e); });
+        size_t hot = LimitHot(exps, opt.hotTop, opt.hotCover);
+        OrderByProfile(exps);
+
+        if (opt.verbose) {
+            fwprintf(stdout, L"[i] Perfil: %zu quentes de %zu exports (%zu com contagem; corte %u%%%ls; %zu não elegíveis: dados/filtrados/forwarders mantidos)%ls\n",
+                hot, exps.size(), m.hot, opt.hotCover, opt.hotTop ? (L", top " + std::to_wstring(opt.hotTop)).c_str() : L"",
+                m.ineligible, opt.hotStubs ? L" -> stubs" : L" -> forwarders (sem --hot-stubs)");
+            for (const auto& s : prof.skipped)
+                fwprintf(stdout, L"[!] Perfil linha %zu ignorada (%ls): %ls\n", s.line, Utf8ToWide(s.reason).c_str(), Utf8ToWide(s.text).c_str());
+            for (const auto& k : m.unmatched)
+                fwprintf(stdout, L"[!] Perfil: chave sem export correspondente: %ls\n", Utf8ToWide(k).c_str());
+            for (const auto& k : m.shadowed)
+                fwprintf(stdout, L"[!] Perfil: %ls ignorado, nome tem precedência\n", Utf8ToWide(k).c_str());
+        }
+    }
+
     // Saídas
     CreateDirectoryW(opt.outDir.c_str(), nullptr);
     std::wstring baseNoExt = BasenameNoExt(opt.inDllName);
@@ -463,12 +619,16 @@ int wmain(int argc, wchar_t** argv) {
         std::wstring hostOut = JoinPath(opt.outDir, L"Host_" + baseNoExt + L".cpp");
         EmitHost(hostOut, baseNoExt);
     }
+    bool hotAsm = opt.hotStubs && std::any_of(exps.begin(), exps.end(), [](const ExportItem& e) { return e.hot; });
+    std::wstring asmOut = JoinPath(opt.outDir, L"hotstubs_x64.asm");
+    if (hotAsm) EmitHotStubsAsm(asmOut, exps);
 
     if (opt.verbose) {
         fwprintf(stdout, L"[+] Gerado: %ls\n", dllmainPath.c_str());
         if (opt.emitDef)  fwprintf(stdout, L"[+] .def: %ls\n", JoinPath(opt.outDir, baseNoExt + L".def").c_str());
         if (opt.emitJson) fwprintf(stdout, L"[+] json: %ls\n", JoinPath(opt.outDir, L"exports_" + baseNoExt + L".json").c_str());
         if (opt.emitHost) fwprintf(stdout, L"[+] host: %ls\n", JoinPath(opt.outDir, L"Host_" + baseNoExt + L".cpp").c_str());
+        if (hotAsm)       fwprintf(stdout, L"[+] asm:  %ls (x64: adicione ao projeto com MASM)\n", asmOut.c_str());
         fwprintf(stdout, L"[i] Renomeie a DLL real para: %ls.dll\n", (baseNoExt + opt.origSuffix).c_str());
         fwprintf(stdout, L"[i] Compile a proxy como: %ls.dll\n", baseNoExt.c_str());
         fwprintf(stdout, L"    Ex.: cl /LD %ls /Fe:%ls\\%ls.dll\n", dllmainPath.c_str(), opt.outDir.c_str(), baseNoExt.c_str());
@@ -0,0 +1,180 @@
+// ProfileLayout.h — layout hot/cold de exports a partir de contagens de chamadas (--profile)
+// Sem dependência de windows.h: compila e é testado em Linux (ver ../tests).
+//
+// Formato do CSV: uma linha por export, "<nome>,<contagem>" ou "#<ordinal>,<contagem>".
+//   - campos aparados dos dois lados; aspas CSV em volta do campo são removidas ("Foo",10)
+//   - BOM UTF-8 e CRLF aceitos; linhas vazias e comentários (';') ignorados
+//   - 1ª linha com contagem não numérica = cabeçalho (ignorado em silêncio)
+//   - demais linhas inválidas e chaves duplicadas vão para CallProfile::skipped
+
+#pragma once
+#include <cstdint>
+#include <cerrno>
+#include <cstdlib>
+#include <algorithm>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+struct ProfileIssue {
+    size_t line{};          // 1-based
+    std::string text;       // linha original (sem CR)
+    std::string reason;
+};
+
+struct CallProfile {
+    std::map<std::string, uint64_t> byName;
+    std::map<uint32_t, uint64_t> byOrdinal;
+    std::vector<ProfileIssue> skipped;
+};
+
+// Resultado de ApplyProfile (para relatório verboso)
+struct ProfileMatch {
+    size_t hot{};                       // quentes antes do corte (LimitHot)
+    size_t ineligible{};                // com contagem > 0 mas rejeitados pelo predicado
+    std::vector<std::string> unmatched; // chaves do perfil sem export correspondente
+    std::vector<std::string> shadowed;  // "#ord" ignorado porque o nome do mesmo export tem precedência
+};
+
+inline std::string ProfileTrim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t");
+    if (b == std::string::npos) return std::string();
+    size_t e = s.find_last_not_of(" \t");
+    return s.substr(b, e - b + 1);
+}
+
+inline std::string ProfileUnquote(const std::string& s) {
+    if (s.size() >= 2 && s.front() == '"' && s.back() == '"') return ProfileTrim(s.substr(1, s.size() - 2));
+    return s;
+}
+
+inline bool ProfileParseU64(const std::string& s, uint64_t& out) {
+    if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos) return false;
+    errno = 0;
+    unsigned long long v = strtoull(s.c_str(), nullptr, 10);
+    if (errno == ERANGE) return false;
+    out = (uint64_t)v;
+    return true;
+}
+
+inline void ParseProfile(std::istream& in, CallProfile& out) {
+    std::map<std::string, size_t> firstLine; // chave -> linha onde apareceu primeiro
+    std::string raw;
+    size_t lineNo = 0;
+    bool sawContent = false;
+
+    while (std::getline(in, raw)) {
+        lineNo++;
+        if (!raw.empty() && raw.back() == '\r') raw.pop_back();
+        if (lineNo == 1 && raw.size() >= 3 && (unsigned char)raw[0] == 0xEF && (unsigned char)raw[1] == 0xBB && (unsigned char)raw[2] == 0xBF)
+            raw.erase(0, 3);
+
+        std::string line = ProfileTrim(raw);
+        if (line.empty() || line[0] == ';') continue;
+        bool first = !sawContent;
+        sawContent = true;
+
+        auto skip = [&](const char* why) { out.skipped.push_back({ lineNo, raw, why }); };
+
+        size_t comma = line.find_last_of(',');
+        if (comma == std::string::npos) { skip("sem vírgula"); continue; }
+        std::string key = ProfileUnquote(ProfileTrim(line.substr(0, comma)));
+        std::string cnt = ProfileUnquote(ProfileTrim(line.substr(comma + 1)));
+
+        uint64_t n = 0;
+        if (!ProfileParseU64(cnt, n)) {
+            if (!first) skip("contagem inválida"); // 1ª linha: cabeçalho
+            continue;
+        }
+        if (key.empty()) { skip("chave vazia"); continue; }
+
+        // chave normalizada: "#02" e "#2" são o mesmo ordinal
+        uint64_t ord = 0;
+        bool isOrd = key[0] == '#';
+        if (isOrd) {
+            if (!ProfileParseU64(key.substr(1), ord) || ord > UINT32_MAX) { skip("ordinal inválido"); continue; }
+            key = "#" + std::to_string(ord);
+        }
+
+        if (!firstLine.emplace(key, lineNo).second) {
+            skip(("chave duplicada (mantida a da linha " + std::to_string(firstLine[key]) + ")").c_str());
+            continue;
+        }
+
+        if (isOrd) out.byOrdinal[(uint32_t)ord] = n;
+        else out.byName[key] = n;
+    }
+}
+
+// Atribui Item::calls/hot. Uma chave por export: o nome tem precedência sobre "#ordinal".
+// Item precisa de: std::string name; <inteiro> ordinal; uint64_t calls; bool hot.
+// eligible(item) decide se o export pode virar stub (filtros, dados, slot vazio...).
+template <class Item, class Pred>
+ProfileMatch ApplyProfile(const CallProfile& p, std::vector<Item>& items, Pred eligible) {
+    ProfileMatch r;
+    std::map<std::string, bool> usedName;
+    std::map<uint32_t, bool> usedOrd;
+
+    for (auto& e : items) {
+        e.calls = 0; e.hot = false;
+        auto io = p.byOrdinal.find((uint32_t)e.ordinal);
+        auto in = e.name.empty() ? p.byName.end() : p.byName.find(e.name);
+
+        if (in != p.byName.end()) {
+            e.calls = in->second;
+            usedName[in->first] = true;
+            if (io != p.byOrdinal.end()) {
+                usedOrd[io->first] = true;
+                r.shadowed.push_back("#" + std::to_string(io->first) + " (usado " + e.name + ")");
+            }
+        }
+        else if (io != p.byOrdinal.end()) {
+            e.calls = io->second;
+            usedOrd[io->first] = true;
+        }
+
+        if (e.calls > 0) {
+            if (eligible(e)) { e.hot = true; r.hot++; }
+            else r.ineligible++;
+        }
+    }
+
+    for (const auto& kv : p.byName)    if (!usedName.count(kv.first)) r.unmatched.push_back(kv.first);
+    for (const auto& kv : p.byOrdinal) if (!usedOrd.count(kv.first))  r.unmatched.push_back("#" + std::to_string(kv.first));
+    return r;
+}
+
+// Corte do conjunto quente: mantém no máximo maxHot exports (0 = sem limite) e só os que, em ordem de
+// contagem desc (empate por ordinal), são necessários para cobrir coverPct% das chamadas elegíveis.
+// Os demais voltam a frios (calls preservado). Retorna o novo total de quentes.
+template <class Item>
+size_t LimitHot(std::vector<Item>& items, size_t maxHot, unsigned coverPct) {
+    std::vector<Item*> hot;
+    uint64_t total = 0;
+    for (auto& e : items) if (e.hot) { hot.push_back(&e); total += e.calls; }
+    std::stable_sort(hot.begin(), hot.end(), [](const Item* a, const Item* b) {
+        if (a->calls != b->calls) return a->calls > b->calls;
+        return a->ordinal < b->ordinal;
+    });
+
+    size_t kept = 0;
+    uint64_t acc = 0;
+    for (auto* e : hot) {
+        bool covered = (double)acc * 100.0 >= (double)total * coverPct;
+        if (covered || (maxHot && kept >= maxHot)) { e->hot = false; continue; }
+        acc += e->calls;
+        kept++;
+    }
+    return kept;
+}
+
+// Layout determinístico: quentes primeiro (contagem desc, empate por ordinal), depois frios na ordem de ordinal.
+template <class Item>
+void OrderByProfile(std::vector<Item>& items) {
+    std::stable_sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        if (a.hot != b.hot) return a.hot;
+        if (a.hot && a.calls != b.calls) return a.calls > b.calls;
+        return a.ordinal < b.ordinal;
+    });
+}
@@ -0,0 +1,186 @@
+// ProfileLayoutBench.cpp — custo do modo --hot-stubs contra forwarders, e ganho do layout por perfil
+// Build/execução: make -C GenProxyPro/tests bench   (Linux x86-64)
+//
+// "DLL real": kExports funções (ret) em slots de kTargetSlot bytes, na ordem de ordinal.
+// Stub emitido (hotstubs_x64.asm): 16 bytes, "jmp qword ptr [rip+disp32]" para gpx_hot_tbl[i] (gravável).
+// As chamadas seguem uma Zipf sobre uma permutação aleatória dos ordinais; um perfil "gravado"
+// (semente diferente) passa por ParseProfile/ApplyProfile/LimitHot/OrderByProfile como no gerador.
+//
+// Cenários (mesma sequência de chamadas):
+//   forwarders      : chamador salta direto no alvo (o que o loader faz com /export:X=orig.X) — baseline
+//   stubs/ordinal   : todo export com stub, stubs na ordem de ordinal (stub mode sem perfil)
+//   hot-stubs/perfil: só os quentes (corte kCover%) têm stub, contíguos em ordem de contagem; frios diretos
+// Os stubs nunca são mais rápidos que forwarders: o modo só existe como ponto de hook; o perfil reduz o custo.
+
+#include "../GenProxyPro/ProfileLayout.h"
+#include <sys/mman.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <set>
+#include <sstream>
+
+#if !defined(__x86_64__)
+#error "benchmark suporta apenas x86-64 (formato do stub de hotstubs_x64.asm)"
+#endif
+
+static const size_t kExports = 65536;
+static const size_t kTargetSlot = 64;
+static const size_t kStubSlot = 16;      // ALIGN 16 do .asm gerado
+static const size_t kCalls = 1u << 22;
+static const double kZipf = 1.2;
+static const unsigned kCover = 90;       // default de --hot-cover
+static const size_t kPage = 4096;
+
+struct Item {
+    std::string name;
+    uint32_t ordinal{};
+    uint64_t calls{};
+    bool hot{};
+};
+
+typedef void (*Fn)();
+
+static std::vector<uint32_t> ZipfSequence(const std::vector<uint32_t>& rankToOrd, size_t n, uint32_t seed) {
+    std::vector<double> w(rankToOrd.size());
+    for (size_t r = 0; r < w.size(); r++) w[r] = 1.0 / std::pow((double)(r + 1), kZipf);
+    std::discrete_distribution<size_t> dist(w.begin(), w.end());
+    std::mt19937 rng(seed);
+    std::vector<uint32_t> seq(n);
+    for (auto& s : seq) s = rankToOrd[dist(rng)];
+    return seq;
+}
+
+static void* Map(size_t bytes) {
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) { perror("mmap"); exit(1); }
+    return p;
+}
+
+static void Protect(void* p, size_t bytes, int prot) {
+    if (mprotect(p, bytes, prot) != 0) { perror("mprotect"); exit(1); }
+}
+
+// alvos: um "ret" por slot
+static unsigned char* MakeTargets() {
+    size_t bytes = kExports * kTargetSlot;
+    unsigned char* t = (unsigned char*)Map(bytes);
+    memset(t, 0xCC, bytes);
+    for (size_t i = 0; i < kExports; i++) t[i * kTargetSlot] = 0xC3;
+    __builtin___clear_cache((char*)t, (char*)t + bytes);
+    Protect(t, bytes, PROT_READ | PROT_EXEC);
+    return t;
+}
+
+// stubs + tabela de ponteiros no mesmo mapeamento (disp32 alcança), tabela fica gravável
+struct StubTable {
+    unsigned char* code{};
+    void** tbl{};
+};
+
+static StubTable MakeStubs(size_t n, const std::vector<unsigned char*>& targets) {
+    size_t codeBytes = (n * kStubSlot + kPage - 1) / kPage * kPage;
+    size_t tblBytes = (n * sizeof(void*) + kPage - 1) / kPage * kPage;
+    unsigned char* base = (unsigned char*)Map(codeBytes + tblBytes);
+    StubTable st{ base, (void**)(base + codeBytes) };
+    memset(st.code, 0xCC, codeBytes);
+    for (size_t i = 0; i < n; i++) {
+        unsigned char* s = st.code + i * kStubSlot;
+        int32_t disp = (int32_t)((unsigned char*)&st.tbl[i] - (s + 6));
+        s[0] = 0xFF; s[1] = 0x25; memcpy(s + 2, &disp, 4);   // jmp qword ptr [rip+disp32]
+        st.tbl[i] = targets[i];
+    }
+    __builtin___clear_cache((char*)st.code, (char*)st.code + codeBytes);
+    Protect(st.code, codeBytes, PROT_READ | PROT_EXEC);
+    return st;
+}
+
+static double Run(const std::vector<Fn>& calls) {
+    double best = 1e30;
+    for (int rep = 0; rep < 5; rep++) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (Fn f : calls) f();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / calls.size());
+    }
+    return best;
+}
+
+// páginas de código da proxy tocadas pelas chamadas que cobrem 90% do total
+static size_t ProxyPages(const std::vector<uint32_t>& seq, const std::vector<long>& stubOf) {
+    std::vector<uint64_t> cnt(kExports + 1);
+    for (auto o : seq) cnt[o]++;
+    std::vector<uint32_t> ords;
+    for (uint32_t o = 1; o <= kExports; o++) if (cnt[o]) ords.push_back(o);
+    std::sort(ords.begin(), ords.end(), [&](uint32_t a, uint32_t b) { return cnt[a] > cnt[b]; });
+    std::set<size_t> pg;
+    uint64_t acc = 0;
+    for (auto o : ords) {
+        if (stubOf[o] >= 0) pg.insert((size_t)stubOf[o] * kStubSlot / kPage);
+        acc += cnt[o];
+        if (acc * 100 >= seq.size() * 90) break;
+    }
+    return pg.size();
+}
+
+int main() {
+    // ranking de popularidade -> ordinal (quentes espalhados na ordem por ordinal)
+    std::vector<uint32_t> rankToOrd(kExports);
+    for (size_t i = 0; i < kExports; i++) rankToOrd[i] = (uint32_t)(i + 1);
+    std::shuffle(rankToOrd.begin(), rankToOrd.end(), std::mt19937(7));
+
+    // perfil "de produção" gravado -> CSV -> quentes/layout, como no gerador
+    auto recorded = ZipfSequence(rankToOrd, kCalls, 1);
+    std::vector<uint64_t> rec(kExports + 1);
+    for (auto o : recorded) rec[o]++;
+    std::ostringstream csv;
+    csv << "name,count\n";
+    for (uint32_t o = 1; o <= kExports; o++) if (rec[o]) csv << "Fn" << o << "," << rec[o] << "\n";
+
+    std::vector<Item> items(kExports);
+    for (uint32_t o = 1; o <= kExports; o++) items[o - 1] = { "Fn" + std::to_string(o), o };
+    std::istringstream in(csv.str());
+    CallProfile prof;
+    ParseProfile(in, prof);
+    ProfileMatch m = ApplyProfile(prof, items, [](const Item&) { return true; });
+    size_t hot = LimitHot(items, 0, kCover);
+    OrderByProfile(items);
+
+    unsigned char* targets = MakeTargets();
+    auto target = [&](uint32_t o) { return targets + (o - 1) * kTargetSlot; };
+
+    // stubs/ordinal: stub i = ordinal i+1
+    std::vector<unsigned char*> tOrd(kExports);
+    std::vector<long> stubOrd(kExports + 1, -1);
+    for (uint32_t o = 1; o <= kExports; o++) { tOrd[o - 1] = target(o); stubOrd[o] = o - 1; }
+    StubTable sOrd = MakeStubs(kExports, tOrd);
+
+    // hot-stubs/perfil: só os quentes, na ordem de OrderByProfile
+    std::vector<unsigned char*> tHot;
+    std::vector<long> stubHot(kExports + 1, -1);
+    for (const auto& e : items) if (e.hot) { stubHot[e.ordinal] = (long)tHot.size(); tHot.push_back(target(e.ordinal)); }
+    StubTable sHot = MakeStubs(tHot.size(), tHot);
+
+    // execução medida: outra amostra da mesma distribuição
+    auto seq = ZipfSequence(rankToOrd, kCalls, 2);
+    std::vector<Fn> direct(seq.size()), viaOrd(seq.size()), viaHot(seq.size());
+    for (size_t i = 0; i < seq.size(); i++) {
+        uint32_t o = seq[i];
+        direct[i] = (Fn)target(o);
+        viaOrd[i] = (Fn)(sOrd.code + stubOrd[o] * kStubSlot);
+        viaHot[i] = stubHot[o] >= 0 ? (Fn)(sHot.code + stubHot[o] * kStubSlot) : (Fn)target(o);
+    }
+
+    Run(direct); // aquecimento
+    double nsDirect = Run(direct), nsOrd = Run(viaOrd), nsHot = Run(viaHot);
+
+    printf("exports=%zu chamadas=%zu zipf=%.2f perfil: %zu com contagem, %zu quentes (cover %u%%)\n",
+        kExports, kCalls, kZipf, m.hot, hot, kCover);
+    printf("%-18s %14s %10s %10s\n", "cenario", "pag.proxy90%", "ns/call", "vs fwd");
+    printf("%-18s %14d %10.2f %9.2fx\n", "forwarders", 0, nsDirect, 1.0);
+    printf("%-18s %14zu %10.2f %9.2fx\n", "stubs/ordinal", ProxyPages(seq, stubOrd), nsOrd, nsOrd / nsDirect);
+    printf("%-18s %14zu %10.2f %9.2fx\n", "hot-stubs/perfil", ProxyPages(seq, stubHot), nsHot, nsHot / nsDirect);
+    return 0;
+}
@@ -0,0 +1,170 @@
+// ProfileLayoutTests.cpp — testes do layout hot/cold (--profile) em Linux
+// Build/execução: make -C GenProxyPro/tests test
+
+#include "../GenProxyPro/ProfileLayout.h"
+#include <cstdio>
+#include <sstream>
+
+struct Item {
+    std::string name;
+    uint32_t ordinal{};
+    uint64_t calls{};
+    bool hot{};
+};
+
+static int gFailures = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "%s:%d: CHECK(%s)\n", __FILE__, __LINE__, #c); gFailures++; } } while (0)
+
+static CallProfile Parse(const std::string& csv) {
+    std::istringstream in(csv);
+    CallProfile p;
+    ParseProfile(in, p);
+    return p;
+}
+
+static std::vector<Item> Items(std::initializer_list<const char*> names) {
+    std::vector<Item> v;
+    uint32_t ord = 1;
+    for (auto n : names) v.push_back({ n, ord++ });
+    return v;
+}
+
+static std::string Order(const std::vector<Item>& v) {
+    std::string s;
+    for (const auto& e : v) { s += e.name.empty() ? "#" + std::to_string(e.ordinal) : e.name; s += e.hot ? "* " : " "; }
+    return s;
+}
+
+static auto kAll = [](const Item&) { return true; };
+
+static void TestHotBeforeColdAndTiesByOrdinal() {
+    auto v = Items({ "A", "B", "C", "D", "E" });
+    auto m = ApplyProfile(Parse("E,5\nB,5\nD,9\n"), v, kAll);
+    OrderByProfile(v);
+    CHECK(m.hot == 3);
+    CHECK(Order(v) == "D* B* E* A C ");
+}
+
+static void TestColdOrderIsStable() {
+    auto v = Items({ "A", "B", "C", "D" });
+    std::swap(v[0], v[3]); // entrada fora de ordem: frios saem por ordinal
+    ApplyProfile(Parse("C,1\n"), v, kAll);
+    OrderByProfile(v);
+    CHECK(Order(v) == "C* A B D ");
+    auto again = v;
+    OrderByProfile(again);
+    CHECK(Order(again) == Order(v));
+}
+
+static void TestBomCrlfAndHeader() {
+    auto p = Parse("\xEF\xBB\xBFname,count\r\nFoo,10\r\n\r\n; comentário\r\nBar,3\r\n");
+    CHECK(p.skipped.empty());
+    CHECK(p.byName.size() == 2);
+    CHECK(p.byName["Foo"] == 10);
+    CHECK(p.byName["Bar"] == 3);
+}
+
+static void TestTrimAndQuotes() {
+    auto p = Parse("\"Foo\",10\n  Bar , 7  \n\t\"Baz\" , \"2\"\t\n");
+    CHECK(p.skipped.empty());
+    CHECK(p.byName["Foo"] == 10);
+    CHECK(p.byName["Bar"] == 7);
+    CHECK(p.byName["Baz"] == 2);
+}
+
+static void TestMalformedLinesAreReported() {
+    auto p = Parse("Foo,1\nsem virgula\nBar,abc\n,5\n#x,3\nBaz,99999999999999999999999\n");
+    CHECK(p.byName.size() == 1);
+    CHECK(p.skipped.size() == 5);
+    if (p.skipped.size() == 5) {
+        CHECK(p.skipped[0].line == 2);
+        CHECK(p.skipped[1].line == 3);
+        CHECK(p.skipped[2].line == 4);
+        CHECK(p.skipped[3].line == 5);
+        CHECK(p.skipped[4].line == 6);
+    }
+}
+
+static void TestOrdinalKeys() {
+    auto v = Items({ "A", "", "C" });
+    auto m = ApplyProfile(Parse("#2,8\n#3,1\n#40,5\n"), v, kAll);
+    OrderByProfile(v);
+    CHECK(Order(v) == "#2* C* A ");
+    CHECK(m.unmatched.size() == 1 && m.unmatched[0] == "#40");
+}
+
+static void TestNameTakesPrecedenceOverOrdinal() {
+    auto v = Items({ "A", "B" });
+    auto m = ApplyProfile(Parse("B,3\n#2,100\nA,5\n"), v, kAll);
+    CHECK(v[1].calls == 3); // não soma 3 + 100
+    CHECK(m.shadowed.size() == 1);
+    CHECK(m.unmatched.empty());
+    OrderByProfile(v);
+    CHECK(Order(v) == "A* B* ");
+}
+
+static void TestDuplicateKeysKeepFirst() {
+    auto p = Parse("Foo,1\nFoo,50\n");
+    CHECK(p.byName["Foo"] == 1);
+    CHECK(p.skipped.size() == 1 && p.skipped[0].line == 2);
+}
+
+static void TestDuplicateOrdinalIsNormalized() {
+    auto p = Parse("#2,5\n#02,9\n");
+    CHECK(p.byOrdinal.size() == 1);
+    CHECK(p.byOrdinal[2] == 5);
+    CHECK(p.skipped.size() == 1 && p.skipped[0].line == 2);
+}
+
+static void TestLimitHotTopN() {
+    auto v = Items({ "A", "B", "C", "D" });
+    ApplyProfile(Parse("A,1\nB,9\nC,9\nD,4\n"), v, kAll);
+    CHECK(LimitHot(v, 2, 100) == 2);
+    OrderByProfile(v);
+    CHECK(Order(v) == "B* C* A D "); // empate B/C por ordinal; D e A voltam a frios
+    CHECK(v[3].calls == 4);
+}
+
+static void TestLimitHotCover() {
+    auto v = Items({ "A", "B", "C", "D" });
+    ApplyProfile(Parse("A,70\nB,20\nC,6\nD,4\n"), v, kAll);
+    CHECK(LimitHot(v, 0, 70) == 1);  // A sozinho cobre 70%
+    ApplyProfile(Parse("A,70\nB,20\nC,6\nD,4\n"), v, kAll);
+    CHECK(LimitHot(v, 0, 90) == 2);
+    ApplyProfile(Parse("A,70\nB,20\nC,6\nD,4\n"), v, kAll);
+    CHECK(LimitHot(v, 0, 91) == 3);
+    ApplyProfile(Parse("A,70\nB,20\nC,6\nD,4\n"), v, kAll);
+    CHECK(LimitHot(v, 0, 100) == 4);
+    ApplyProfile(Parse("A,70\nB,20\nC,6\nD,4\n"), v, kAll);
+    CHECK(LimitHot(v, 1, 100) == 1);
+    OrderByProfile(v);
+    CHECK(Order(v) == "A* B C D ");
+}
+
+static void TestUnmatchedAndIneligible() {
+    auto v = Items({ "A", "B", "C" });
+    auto m = ApplyProfile(Parse("A,5\nB,4\nTypo,9\nC,0\n"), v, [](const Item& e) { return e.name != "B"; });
+    CHECK(m.hot == 1);
+    CHECK(m.ineligible == 1);
+    CHECK(!v[1].hot && v[1].calls == 4);
+    CHECK(!v[2].hot); // contagem 0 nunca é quente
+    CHECK(m.unmatched.size() == 1 && m.unmatched[0] == "Typo");
+}
+
+int main() {
+    TestHotBeforeColdAndTiesByOrdinal();
+    TestColdOrderIsStable();
+    TestBomCrlfAndHeader();
+    TestTrimAndQuotes();
+    TestMalformedLinesAreReported();
+    TestOrdinalKeys();
+    TestNameTakesPrecedenceOverOrdinal();
+    TestDuplicateKeysKeepFirst();
+    TestDuplicateOrdinalIsNormalized();
+    TestLimitHotTopN();
+    TestLimitHotCover();
+    TestUnmatchedAndIneligible();
+    if (gFailures) { fprintf(stderr, "%d falha(s)\n", gFailures); return 1; }
+    printf("ProfileLayoutTests: ok\n");
+    return 0;
+}